@@ -440,6 +440,11 @@ LIPCcode LipcGetStringProperty(LIPC *lipc, const char *service,
 /**
  * Set the value of the string property.
  *
+ * @note
+ * The value is transferred as a D-Bus string, so it has to be a valid UTF-8
+ * sequence. Arbitrary bytes (e.g. file names from FAT volumes) should be
+ * encoded by the caller beforehand.
+ *
  * @param lipc LIPC library handler.
  * @param service The service name.
  * @param property The property name.
@@ -473,6 +478,18 @@ LIPCcode LipcAccessHasharrayProperty(LIPC *lipc, const char *service,
  * The access mode of the property can be either read-only: r, write-only: w,
  * or both: rw.
  *
+ * @note
+ * Tools from the [open]lipc project (e.g. lipc-probe) recognize an optional
+ * "_values" hash-array property. It is not a part of the LIPC library - it
+ * is a convention, which one can implement with the
+ * LipcRegisterHasharrayProperty(). If the service lists a readable "_values"
+ * property, it should return a hash-array with at least one hash. The first
+ * hash (index 0) should contain the current values of readable properties,
+ * where the key is the property name and the value type matches the property
+ * type: LIPC_HASHARRAY_INT for "Int" and LIPC_HASHARRAY_STRING for "Str"
+ * properties. Other properties may be omitted, and values with a mismatched
+ * type are ignored - such properties are accessed directly instead.
+ *
  * @param lipc LIPC library handler.
  * @param service The service name.
  * @param value The address where the pointer to the string will stored.
@@ -734,6 +751,10 @@ LIPCcode LipcGetStringParam(LIPCevent *event, char **value);
 /**
  * Add the string parameter to the event.
  *
+ * @note
+ * The same as for the LipcSetStringProperty(), the value has to be a valid
+ * UTF-8 sequence.
+ *
  * @param event LIPC event handler.
  * @param value The new value to add.
  * @return The status code. */
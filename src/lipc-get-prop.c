@@ -14,9 +14,13 @@
 
 #include "openlipc.h"
 
+#include <ctype.h>
+#include <errno.h>
 #include <getopt.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <syslog.h>
 
 
@@ -26,6 +30,143 @@ enum property {
 	PROPERTY_HAS,
 };
 
+/* Hash-array printing options. The count of -1 means "up to the end", and
+ * the truncate value of 0 disables string values truncation. */
+struct ha_filter {
+	int first;
+	int count;
+	char **keys;
+	size_t keys_count;
+	size_t truncate;
+};
+
+/* Print single value from the hash map in the same format, which is used by
+ * the LipcHasharrayToString() function. */
+static LIPCcode print_hasharray_value(LIPCha *ha, int index, const char *key,
+		LIPCHasharrayType type, size_t truncate) {
+
+	LIPCcode code = LIPC_OK;
+
+	switch (type) {
+	case LIPC_HASHARRAY_INT: {
+		int value;
+		if ((code = LipcHasharrayGetInt(ha, index, key, &value)) == LIPC_OK)
+			printf(" %s=%d", key, value);
+		break;
+	}
+	case LIPC_HASHARRAY_STRING: {
+		char *value;
+		if ((code = LipcHasharrayGetString(ha, index, key, &value)) != LIPC_OK)
+			break;
+		if (truncate && strlen(value) > truncate) {
+			/* do not split multi-byte UTF-8 character */
+			while (truncate > 0 && (value[truncate] & 0xC0) == 0x80)
+				truncate--;
+			printf(" %s=\"%.*s...\"", key, (int)truncate, value);
+		}
+		else
+			printf(" %s=\"%s\"", key, value);
+		break;
+	}
+	default:
+		printf(" %s=(binary)", key);
+	}
+
+	return code;
+}
+
+/* Print the subset of the hash-array selected by the filter. This function
+ * walks only through requested hashes and keys, so it is much cheaper than
+ * formatting the whole hash-array with the LipcHasharrayToString(). */
+static LIPCcode print_hasharray(LIPCha *ha, const struct ha_filter *filter) {
+
+	const char **keys = NULL;
+	LIPCHasharrayType type;
+	LIPCcode code = LIPC_OK;
+	int i, last;
+	size_t j, size;
+
+	if ((last = LipcHasharrayGetHashCount(ha)) == -1)
+		return LIPC_ERROR_INVALID_ARG;
+	if (filter->count != -1 && filter->count < last - filter->first)
+		last = filter->first + filter->count;
+
+	printf(" ");
+	for (i = filter->first; i < last; i++) {
+
+		printf("%d:{", i);
+
+		if (filter->keys_count) {
+			for (j = 0; j < filter->keys_count; j++) {
+				/* keys missing in the current hash are silently omitted */
+				if (LipcHasharrayCheckKey(ha, i, filter->keys[j], &type, &size) != LIPC_OK)
+					continue;
+				if ((code = print_hasharray_value(ha, i, filter->keys[j], type,
+								filter->truncate)) != LIPC_OK)
+					break;
+			}
+		}
+		else {
+			size_t count = 0;
+			if ((code = LipcHasharrayKeys(ha, i, NULL, &count)) != LIPC_OK)
+				break;
+			if ((keys = realloc(keys, sizeof(*keys) * (count + 1))) == NULL) {
+				code = LIPC_ERROR_OUT_OF_MEMORY;
+				break;
+			}
+			if ((code = LipcHasharrayKeys(ha, i, keys, &count)) != LIPC_OK)
+				break;
+			for (j = 0; j < count; j++)
+				if ((code = LipcHasharrayCheckKey(ha, i, keys[j], &type, &size)) != LIPC_OK ||
+						(code = print_hasharray_value(ha, i, keys[j], type,
+								filter->truncate)) != LIPC_OK)
+					break;
+		}
+
+		if (code != LIPC_OK)
+			break;
+
+		printf(" }\n ");
+	}
+
+	free(keys);
+	return code;
+}
+
+/* Parse non-negative integer, which has to fit in the int type. On success
+ * this function returns 1 and the end pointer is stored in the endptr. */
+static int parse_int(const char *str, int *value, char **endptr) {
+
+	long tmp;
+
+	if (!isdigit((unsigned char)*str))
+		return 0;
+
+	errno = 0;
+	tmp = strtol(str, endptr, 10);
+	if (errno == ERANGE || tmp > INT_MAX)
+		return 0;
+
+	*value = tmp;
+	return 1;
+}
+
+/* Split comma-separated list of keys. The given string is modified. */
+static char **split_keys(char *str, size_t *count) {
+
+	char **keys = NULL;
+	char *tmp;
+
+	*count = 0;
+	for (tmp = strtok(str, ","); tmp != NULL; tmp = strtok(NULL, ",")) {
+		if ((keys = realloc(keys, sizeof(*keys) * (*count + 1))) == NULL)
+			return NULL;
+		keys[(*count)++] = tmp;
+	}
+
+	return keys;
+}
+
 int main(int argc, char *argv[]) {
 
 	int opt;
@@ -34,10 +175,15 @@ int main(int argc, char *argv[]) {
 	int end_nl = 1;
 	int quiet = 0;
 
-	while ((opt = getopt(argc, argv, "hisjeq")) != -1)
+	struct ha_filter filter = { 0, -1, NULL, 0, 0 };
+	int filter_enabled = 0;
+	char *tmp;
+
+	while ((opt = getopt(argc, argv, "hisjeqr:k:t:")) != -1)
 		switch (opt) {
 		case 'h':
-			printf("usage: %s [-isjeq] <publisher> <property>\n\n"
+			printf("usage: %s [-isjeq] [-r <first>[:<count>]] [-k <key>[,...]] [-t <length>]\n"
+				"          <publisher> <property>\n\n"
 				"  publisher - the unique name of the publisher\n"
 				"  property  - the name of the property to get\n"
 				"\n"
@@ -46,7 +192,12 @@ int main(int argc, char *argv[]) {
 				"  -s\tpublisher published a string property\n"
 				"  -j\tpublisher published a hash-array property\n"
 				"  -e\tdo not print new line at the end\n"
-				"  -q\tdo not print error message\n",
+				"  -q\tdo not print error message\n"
+				"\n"
+				"hash-array options (valid only with -j):\n"
+				"  -r\tprint only hashes from the given index range\n"
+				"  -k\tprint only values for the given comma-separated keys\n"
+				"  -t\ttruncate string values to the given length\n",
 				argv[0]);
 			return EXIT_SUCCESS;
 
@@ -66,6 +217,36 @@ int main(int argc, char *argv[]) {
 			quiet = 1;
 			break;
 
+		case 'r':
+			filter.count = -1;
+			if (!parse_int(optarg, &filter.first, &tmp) ||
+					(*tmp == ':' && !parse_int(tmp + 1, &filter.count, &tmp)) ||
+					*tmp != '\0') {
+				fprintf(stderr, "error: invalid range: %s\n", optarg);
+				return EXIT_FAILURE;
+			}
+			filter_enabled = 1;
+			break;
+		case 'k':
+			free(filter.keys);
+			if ((filter.keys = split_keys(optarg, &filter.keys_count)) == NULL) {
+				fprintf(stderr, "error: invalid key list: %s\n", optarg);
+				return EXIT_FAILURE;
+			}
+			filter_enabled = 1;
+			break;
+		case 't':
+			errno = 0;
+			tmp = optarg;
+			if (isdigit((unsigned char)*optarg))
+				filter.truncate = strtoul(optarg, &tmp, 10);
+			if (tmp == optarg || *tmp != '\0' || errno == ERANGE) {
+				fprintf(stderr, "error: invalid length: %s\n", optarg);
+				return EXIT_FAILURE;
+			}
+			filter_enabled = 1;
+			break;
+
 		default:
 usage:
 			fprintf(stderr, "Try '%s -h' for more information.\n", argv[0]);
@@ -75,6 +256,11 @@ usage:
 	if (argc - optind != 2)
 		goto usage;
 
+	if (filter_enabled && kind != PROPERTY_HAS) {
+		fprintf(stderr, "error: options -r, -k and -t are valid only with -j\n");
+		goto usage;
+	}
+
 	const char *source = argv[optind];
 	const char *property = argv[optind + 1];
 	LIPCcode code;
@@ -109,10 +295,25 @@ usage:
 		LIPCha *ha = NULL;
 		char *value = NULL;
 		size_t size = 0;
-		if ((code = LipcAccessHasharrayProperty(lipc, source, property, NULL, &ha)) == LIPC_OK &&
-				(code = LipcHasharrayToString(ha, NULL, &size)) == LIPC_OK &&
-				(code = LipcHasharrayToString(ha, value = malloc(size), &size)) == LIPC_OK)
-			printf(" %s", value);
+		if ((code = LipcAccessHasharrayProperty(lipc, source, property, NULL, &ha)) == LIPC_OK) {
+			if (filter_enabled) {
+				/* starting index 0 is always valid, so an empty hash-array can
+				 * be printed with other filtering options */
+				int count = LipcHasharrayGetHashCount(ha);
+				if (filter.first > 0 && filter.first >= count) {
+					if (!quiet)
+						fprintf(stderr, "error: range out of bounds: %d (hash count: %d)\n",
+								filter.first, count);
+					LipcHasharrayDestroy(ha);
+					code = LIPC_ERROR_INVALID_ARG;
+					goto fail;
+				}
+				code = print_hasharray(ha, &filter);
+			}
+			else if ((code = LipcHasharrayToString(ha, NULL, &size)) == LIPC_OK &&
+					(code = LipcHasharrayToString(ha, value = malloc(size), &size)) == LIPC_OK)
+				printf(" %s", value);
+		}
 		if (ha != NULL)
 			LipcHasharrayDestroy(ha);
 		free(value);
@@ -128,6 +329,8 @@ usage:
 				source, property, code, LipcGetErrorString(code));
 	}
 
+fail:
 	LipcClose(lipc);
+	free(filter.keys);
 	return code == LIPC_OK ? EXIT_SUCCESS : EXIT_FAILURE;
 }
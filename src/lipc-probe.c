@@ -173,6 +173,63 @@ static gint property_name_cmp(gconstpointer a, gconstpointer b) {
 	return g_ascii_strcasecmp(_a->name, _b->name);
 }
 
+static gint property_readable_has_cmp(gconstpointer a, gconstpointer b) {
+	struct lipc_property *_a = (struct lipc_property *)a;
+	if (_a->type != LIPC_PROPERTY_TYPE_HAS || !(_a->mode & LIPC_PROPERTY_MODE_R))
+		return -1;
+	return g_strcmp0(_a->name, (const gchar *)b);
+}
+
+/* Get the snapshot of all readable property values. For the layout of the
+ * "_values" hash-array see the LipcGetProperties() documentation. Using it
+ * saves one round trip per property. If the service does not support such
+ * a snapshot, NULL is returned. */
+static LIPCha *get_values(LIPC *lipc, const char *source, GSList *properties) {
+
+	LIPCha *ha = NULL;
+
+	if (g_slist_find_custom(properties, "_values", property_readable_has_cmp) == NULL)
+		return NULL;
+
+	if (LipcAccessHasharrayProperty(lipc, source, "_values", NULL, &ha) != LIPC_OK ||
+			LipcHasharrayGetHashCount(ha) < 1) {
+		if (ha != NULL)
+			LipcHasharrayDestroy(ha);
+		return NULL;
+	}
+
+	return ha;
+}
+
+/* Check whether the "_values" snapshot holds the value of the property. The
+ * snapshot value is used only if its type matches the property type. */
+static gboolean has_snapshot_value(LIPCha *values, const struct lipc_property *property) {
+
+	LIPCHasharrayType type;
+	size_t size;
+
+	if (values == NULL ||
+			LipcHasharrayCheckKey(values, 0, property->name, &type, &size) != LIPC_OK)
+		return FALSE;
+
+	return (type == LIPC_HASHARRAY_INT && property->type == LIPC_PROPERTY_TYPE_INT) ||
+		(type == LIPC_HASHARRAY_STRING && property->type == LIPC_PROPERTY_TYPE_STR);
+}
+
+/* Print the value of the property taken from the "_values" snapshot. */
+static void print_snapshot_value(LIPCha *values, const struct lipc_property *property) {
+	if (property->type == LIPC_PROPERTY_TYPE_INT) {
+		int value;
+		if (LipcHasharrayGetInt(values, 0, property->name, &value) == LIPC_OK)
+			printf("\t[%d]", value);
+	}
+	else {
+		char *value;
+		if (LipcHasharrayGetString(values, 0, property->name, &value) == LIPC_OK)
+			printf("\t[%s]", value);
+	}
+}
+
 int main(int argc, char *argv[]) {
 
 	int opt;
@@ -190,7 +247,10 @@ int main(int argc, char *argv[]) {
 				"options:\n"
 				"  -l\tlist all available services in the system\n"
 				"  -a\tlist and probe all available services\n"
-				"  -v\tshow value for all readable properties\n",
+				"  -v\tshow value for all readable properties\n"
+				"\n"
+				"If the publisher exposes the readable \"_values\" hash-array property, values\n"
+				"are taken from this snapshot instead of accessing every property separately.\n",
 				argv[0]);
 			return EXIT_SUCCESS;
 
@@ -243,8 +303,12 @@ usage:
 		if (value_probe) {
 
 			GSList *properties = NULL;
+			LIPCha *values = NULL;
 			get_properties(lipc, source, &properties);
 
+			if (value_get)
+				values = get_values(lipc, source, properties);
+
 			/* help reading the output by sorting properties */
 			properties = g_slist_sort(properties, property_name_cmp);
 
@@ -257,7 +321,9 @@ usage:
 
 				if (value_get && property->mode && LIPC_PROPERTY_MODE_R) {
 
-					if (property->type == LIPC_PROPERTY_TYPE_INT) {
+					if (has_snapshot_value(values, property))
+						print_snapshot_value(values, property);
+					else if (property->type == LIPC_PROPERTY_TYPE_INT) {
 						int value;
 						if (LipcGetIntProperty(lipc, source, property->name, &value) == LIPC_OK)
 							printf("\t[%d]", value);
@@ -285,6 +351,9 @@ usage:
 
 			}
 
+			if (values != NULL)
+				LipcHasharrayDestroy(values);
+
 		}
 
 		/* free resources and get next element */
@@ -0,0 +1,371 @@
+/*
+ * [open]lipc - lipc-sample.c
+ * Copyright (c) 2016 Arkadiusz Bokowy
+ *
+ * This file is a part of openlipc.
+ *
+ * This project is licensed under the terms of the MIT license.
+ *
+ */
+
+#include "openlipc.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <getopt.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+
+
+enum property {
+	PROPERTY_UNSUPPORTED,
+	PROPERTY_INT,
+	PROPERTY_STR,
+};
+
+struct sample_source {
+	char *publisher;
+	char *property;
+	enum property kind;
+	/* column index in the output */
+	int column;
+};
+
+struct sample_value {
+	enum property kind;
+	int valid;
+	int integer;
+	char *string;
+};
+
+struct sample_stats {
+	unsigned long samples;
+	unsigned long overruns;
+	int64_t jitter_min;
+	int64_t jitter_max;
+	int64_t jitter_sum;
+};
+
+
+static volatile sig_atomic_t sampling = 1;
+
+static void sigint_handler(int sig) {
+	(void)sig;
+	sampling = 0;
+}
+
+static int64_t timespec_to_ns(const struct timespec *ts) {
+	return (int64_t)ts->tv_sec * 1000000000 + ts->tv_nsec;
+}
+
+static int source_cmp(const void *a, const void *b) {
+	const struct sample_source *_a = (const struct sample_source *)a;
+	const struct sample_source *_b = (const struct sample_source *)b;
+	int rv;
+	if ((rv = strcmp(_a->publisher, _b->publisher)) != 0)
+		return rv;
+	return _a->column - _b->column;
+}
+
+/* Determine property types of all sources provided by the given publisher.
+ * The list of properties is fetched once per publisher, so the number of
+ * round trips does not depend on the number of sampled properties. */
+static LIPCcode resolve_types(LIPC *lipc, struct sample_source *sources, size_t count) {
+
+	char *value, *name, *type, *mode, *tmp;
+	LIPCcode code;
+	size_t i;
+
+	if ((code = LipcGetProperties(lipc, sources[0].publisher, &value)) != LIPC_OK)
+		return code;
+
+	for (name = strtok_r(value, " ", &tmp); name != NULL; name = strtok_r(NULL, " ", &tmp)) {
+		if ((type = strtok_r(NULL, " ", &tmp)) == NULL ||
+				(mode = strtok_r(NULL, " ", &tmp)) == NULL)
+			break;
+		/* write-only properties can not be sampled */
+		if (strchr(mode, 'r') == NULL)
+			continue;
+		for (i = 0; i < count; i++)
+			if (strcmp(sources[i].property, name) == 0) {
+				if (strcmp(type, "Int") == 0)
+					sources[i].kind = PROPERTY_INT;
+				else if (strcmp(type, "Str") == 0)
+					sources[i].kind = PROPERTY_STR;
+			}
+	}
+
+	LipcFreeString(value);
+
+	for (i = 0; i < count; i++)
+		if (sources[i].kind == PROPERTY_UNSUPPORTED) {
+			fprintf(stderr, "error: %s has no readable integer or string property %s\n",
+					sources[i].publisher, sources[i].property);
+			return LIPC_ERROR_NO_SUCH_PROPERTY;
+		}
+
+	return LIPC_OK;
+}
+
+/* Print string value as a CSV field - double quotes are escaped by doubling
+ * them, as specified in the RFC 4180. */
+static void print_csv_string(FILE *f, const char *str) {
+	fputc('"', f);
+	for (; *str != '\0'; str++) {
+		if (*str == '"')
+			fputc('"', f);
+		fputc(*str, f);
+	}
+	fputc('"', f);
+}
+
+int main(int argc, char *argv[]) {
+
+	int opt;
+
+	double frequency = 10;
+	unsigned long limit = 0;
+	const char *output = NULL;
+	int quiet = 0;
+	char *tmp;
+
+	while ((opt = getopt(argc, argv, "hf:n:o:q")) != -1)
+		switch (opt) {
+		case 'h':
+			printf("usage: %s [-q] [-f <frequency>] [-n <count>] [-o <file>]\n"
+				"          <publisher>:<property> [<publisher>:<property>] ...\n\n"
+				"  publisher - the unique name of the publisher\n"
+				"  property  - the name of the integer or string property to sample\n"
+				"\n"
+				"options:\n"
+				"  -f\tsampling frequency in Hz (default: 10)\n"
+				"  -n\tnumber of samples to take (default: until interrupted)\n"
+				"  -o\twrite CSV time series into the given file\n"
+				"  -q\tdo not print sampling statistics\n"
+				"\n"
+				"Every row contains the sample time and the jitter of the sampling schedule\n"
+				"(both relative to the scheduled time), the time spent on reading values and\n"
+				"the sampled values. Values which could not be read are left empty.\n",
+				argv[0]);
+			return EXIT_SUCCESS;
+
+		case 'f':
+			frequency = strtod(optarg, &tmp);
+			/* The sampling interval in nanoseconds has to fit in the int64_t type
+			 * with a headroom for adding it to the current monotonic time. */
+			if (tmp == optarg || *tmp != '\0' ||
+					!(frequency > 0) || frequency > 1000000 ||
+					1e9 / frequency > INT64_MAX / 2) {
+				fprintf(stderr, "error: invalid frequency: %s\n", optarg);
+				return EXIT_FAILURE;
+			}
+			break;
+		case 'n':
+			errno = 0;
+			tmp = optarg;
+			if (isdigit((unsigned char)*optarg))
+				limit = strtoul(optarg, &tmp, 10);
+			if (tmp == optarg || *tmp != '\0' || errno == ERANGE || limit == 0) {
+				fprintf(stderr, "error: invalid count: %s\n", optarg);
+				return EXIT_FAILURE;
+			}
+			break;
+		case 'o':
+			output = optarg;
+			break;
+		case 'q':
+			quiet = 1;
+			break;
+
+		default:
+usage:
+			fprintf(stderr, "Try '%s -h' for more information.\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+
+	if (argc - optind < 1)
+		goto usage;
+
+	struct sample_source *sources;
+	struct sample_value *values = NULL;
+	FILE *f = NULL;
+	LIPCcode code;
+	LIPC *lipc;
+	int fd;
+	size_t sources_count = argc - optind;
+	size_t i, j;
+
+	if ((sources = calloc(sources_count, sizeof(*sources))) == NULL) {
+		fprintf(stderr, "error: %s\n", strerror(errno));
+		return EXIT_FAILURE;
+	}
+
+	for (i = 0; i < sources_count; i++) {
+		tmp = argv[optind + i];
+		sources[i].publisher = tmp;
+		sources[i].column = i;
+		if ((tmp = strrchr(tmp, ':')) == NULL || tmp[1] == '\0') {
+			fprintf(stderr, "error: invalid property: %s\n", argv[optind + i]);
+			free(sources);
+			goto usage;
+		}
+		*tmp = '\0';
+		sources[i].property = tmp + 1;
+	}
+
+	/* Group properties by the publisher, so all reads from one publisher are
+	 * performed one after another. Column order is preserved in the output. */
+	qsort(sources, sources_count, sizeof(*sources), source_cmp);
+
+	LipcSetLlog(LAB126_LOG_ALL & ~LAB126_LOG_DEBUG_ALL);
+	if ((lipc = LipcOpenNoName()) == NULL) {
+		fprintf(stderr, "error: failed to open lipc\n");
+		free(sources);
+		return EXIT_FAILURE;
+	}
+
+	/* open the output after LIPC, so it is not truncated if LIPC fails */
+	if ((f = output != NULL ? fopen(output, "w") : stdout) == NULL) {
+		fprintf(stderr, "error: %s: %s\n", output, strerror(errno));
+		code = LIPC_ERROR_INTERNAL;
+		goto fail;
+	}
+
+	for (i = 0; i < sources_count; i = j) {
+		for (j = i + 1; j < sources_count; j++)
+			if (strcmp(sources[i].publisher, sources[j].publisher) != 0)
+				break;
+		if ((code = resolve_types(lipc, &sources[i], j - i)) != LIPC_OK) {
+			if (code != LIPC_ERROR_NO_SUCH_PROPERTY)
+				fprintf(stderr, "error: %s failed to access properties (0x%x %s)\n",
+						sources[i].publisher, code, LipcGetErrorString(code));
+			goto fail;
+		}
+	}
+
+	if ((values = calloc(sources_count, sizeof(*values))) == NULL) {
+		fprintf(stderr, "error: %s\n", strerror(errno));
+		code = LIPC_ERROR_OUT_OF_MEMORY;
+		goto fail;
+	}
+
+	for (i = 0; i < sources_count; i++)
+		values[sources[i].column].kind = sources[i].kind;
+
+	int64_t interval = 1000000000 / frequency;
+	struct itimerspec timer = { 0 };
+	struct timespec ts;
+
+	if ((fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC)) == -1) {
+		fprintf(stderr, "error: %s\n", strerror(errno));
+		code = LIPC_ERROR_INTERNAL;
+		goto fail;
+	}
+
+	/* use an absolute schedule, so the timer does not drift due to the time
+	 * spent on reading values */
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	int64_t start = timespec_to_ns(&ts) + interval;
+	timer.it_value.tv_sec = start / 1000000000;
+	timer.it_value.tv_nsec = start % 1000000000;
+	timer.it_interval.tv_sec = interval / 1000000000;
+	timer.it_interval.tv_nsec = interval % 1000000000;
+	if (timerfd_settime(fd, TFD_TIMER_ABSTIME, &timer, NULL) == -1) {
+		fprintf(stderr, "error: %s\n", strerror(errno));
+		code = LIPC_ERROR_INTERNAL;
+		goto fail_timer;
+	}
+
+	struct sigaction sigact = { .sa_handler = sigint_handler };
+	sigaction(SIGINT, &sigact, NULL);
+	sigaction(SIGTERM, &sigact, NULL);
+
+	fprintf(f, "time,jitter,duration");
+	for (i = 0; i < sources_count; i++)
+		for (j = 0; j < sources_count; j++)
+			if (sources[j].column == (int)i)
+				fprintf(f, ",%s:%s", sources[j].publisher, sources[j].property);
+	fprintf(f, "\n");
+
+	struct sample_stats stats = { 0, 0, INT64_MAX, INT64_MIN, 0 };
+	int64_t scheduled = start;
+	uint64_t expirations;
+
+	while (sampling && (limit == 0 || stats.samples < limit)) {
+
+		if (read(fd, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+			if (errno == EINTR)
+				continue;
+			fprintf(stderr, "error: %s\n", strerror(errno));
+			code = LIPC_ERROR_INTERNAL;
+			break;
+		}
+
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		int64_t now = timespec_to_ns(&ts);
+
+		/* missed ticks are not sampled, but they are accounted */
+		scheduled += (expirations - 1) * interval;
+		stats.overruns += expirations - 1;
+
+		for (i = 0; i < sources_count; i++) {
+			struct sample_source *source = &sources[i];
+			struct sample_value *value = &values[source->column];
+			if (source->kind == PROPERTY_INT)
+				value->valid = LipcGetIntProperty(lipc, source->publisher,
+						source->property, &value->integer) == LIPC_OK;
+			else
+				value->valid = LipcGetStringProperty(lipc, source->publisher,
+						source->property, &value->string) == LIPC_OK;
+		}
+
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		int64_t jitter = now - scheduled;
+
+		fprintf(f, "%.6f,%.6f,%.6f", (scheduled - start) / 1e9, jitter / 1e9,
+				(timespec_to_ns(&ts) - now) / 1e9);
+		for (i = 0; i < sources_count; i++) {
+			struct sample_value *value = &values[i];
+			fputc(',', f);
+			if (!value->valid)
+				continue;
+			if (value->kind == PROPERTY_INT)
+				fprintf(f, "%d", value->integer);
+			else {
+				print_csv_string(f, value->string);
+				LipcFreeString(value->string);
+			}
+		}
+		fputc('\n', f);
+
+		if (jitter < stats.jitter_min)
+			stats.jitter_min = jitter;
+		if (jitter > stats.jitter_max)
+			stats.jitter_max = jitter;
+		stats.jitter_sum += jitter;
+		stats.samples++;
+		scheduled += interval;
+
+	}
+
+	if (!quiet && stats.samples)
+		fprintf(stderr, "samples: %lu, overruns: %lu, jitter: min=%.1fus avg=%.1fus max=%.1fus\n",
+				stats.samples, stats.overruns, stats.jitter_min / 1e3,
+				(double)stats.jitter_sum / stats.samples / 1e3, stats.jitter_max / 1e3);
+
+fail_timer:
+	close(fd);
+fail:
+	if (f != NULL && f != stdout)
+		fclose(f);
+	LipcClose(lipc);
+	free(values);
+	free(sources);
+	return code == LIPC_OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -16,10 +16,78 @@
 
 #include <getopt.h>
 #include <stdio.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <syslog.h>
 
 
+/* Check whether the given string is a valid UTF-8 sequence. D-Bus requires
+ * all strings to be valid UTF-8, so it is better to fail early with a clear
+ * message. Runs of ASCII characters are checked one machine word at a time,
+ * which makes the check almost free for typical values. */
+static int utf8_validate(const char *str) {
+
+	const unsigned char *s = (const unsigned char *)str;
+	const unsigned char *end = s + strlen(str);
+	const uintptr_t mask = (uintptr_t)0x8080808080808080ULL;
+	unsigned char lower, upper;
+	uintptr_t word;
+	size_t n;
+
+	while (s < end) {
+
+		while ((size_t)(end - s) >= sizeof(word)) {
+			memcpy(&word, s, sizeof(word));
+			if (word & mask)
+				break;
+			s += sizeof(word);
+		}
+
+		if (s == end)
+			break;
+		if (*s < 0x80) {
+			s++;
+			continue;
+		}
+
+		/* Determine the number of continuation bytes and the valid range of
+		 * the first one - this rejects overlong encodings, surrogates and
+		 * code points above U+10FFFF. */
+		lower = 0x80;
+		upper = 0xBF;
+		if (*s >= 0xC2 && *s <= 0xDF)
+			n = 1;
+		else if (*s >= 0xE0 && *s <= 0xEF) {
+			n = 2;
+			if (*s == 0xE0)
+				lower = 0xA0;
+			if (*s == 0xED)
+				upper = 0x9F;
+		}
+		else if (*s >= 0xF0 && *s <= 0xF4) {
+			n = 3;
+			if (*s == 0xF0)
+				lower = 0x90;
+			if (*s == 0xF4)
+				upper = 0x8F;
+		}
+		else
+			return 0;
+
+		if ((size_t)(end - ++s) < n)
+			return 0;
+		if (*s < lower || *s > upper)
+			return 0;
+		while (n--)
+			if ((*s++ & 0xC0) != 0x80)
+				return 0;
+
+	}
+
+	return 1;
+}
+
 int main(int argc, char *argv[]) {
 
 	int opt;
@@ -95,14 +163,17 @@ usage:
 		}
 		code = LipcSetIntProperty(lipc, source, property, value_int);
 	}
-	else if (string) {
+	else if (string || *tmp != '\0') {
+		if (!utf8_validate(value)) {
+			if (!quiet)
+				fprintf(stderr, "error: value is not a valid UTF-8 string\n");
+			code = LIPC_ERROR_INVALID_ARG;
+			goto fail;
+		}
 		code = LipcSetStringProperty(lipc, source, property, value);
 	}
 	else {
-		if (*tmp == '\0')
-			code = LipcSetIntProperty(lipc, source, property, value_int);
-		else
-			code = LipcSetStringProperty(lipc, source, property, value);
+		code = LipcSetIntProperty(lipc, source, property, value_int);
 	}
 
 	if (code != LIPC_OK && !quiet) {